@@ -116,6 +116,9 @@ struct wl_display
 	pthread_cond_t reader_cond;
 };
 
+_Static_assert(sizeof(struct wl_proxy) <= sizeof(struct wl_proxy_wrapper_storage),
+			   "wl_proxy_wrapper_storage too small for struct wl_proxy");
+
 /** \endcond */
 
 static int debug_client = 0;
@@ -231,6 +234,94 @@ wl_display_create_queue(struct wl_display *display)
 	return NULL;
 }
 
+/** Get a file descriptor that signals pending events on a queue
+ *
+ * \param queue The event queue
+ * \return An eventfd owned by the queue or -1 on failure
+ *
+ * Return an eventfd that becomes readable whenever events are queued on
+ * \c queue. A thread that owns a private queue can add this fd to its own
+ * poll or epoll set and dispatch only that queue when it fires, instead of
+ * coordinating with other threads on the display fd.
+ *
+ * The eventfd is only reset once the queue is empty. A call to
+ * wl_display_dispatch_queue_pending() drains the queue and resets it. A
+ * call to wl_display_dispatch_queue_pending_budget() that returns a
+ * positive count leaves it readable, because events remain.
+ *
+ * Events still have to be read from the display fd by some thread, see
+ * wl_display_prepare_read_queue(); this fd only reports that reading has
+ * queued something for \c queue.
+ *
+ * The fd is owned by the queue and closed by wl_event_queue_destroy(). The
+ * caller must not read from, write to or close it.
+ *
+ * \memberof wl_event_queue
+ */
+WL_EXPORT int
+wl_event_queue_get_fd(struct wl_event_queue *queue)
+{
+	return -1;
+}
+
+/** Set the coalescing policy for one event of a proxy
+ *
+ * \param queue The event queue the proxy's events are queued on
+ * \param proxy The proxy whose events should be coalesced
+ * \param opcode Opcode of the event to coalesce
+ * \param key_args Bitmask of argument indices that must match for a merge
+ * \param mode The coalescing policy
+ * \return 0 on success or -1 on failure
+ *
+ * High-frequency input such as pointer motion, axis or touch motion can
+ * arrive much faster than a client renders. With a policy other than
+ * WL_EVENT_COALESCE_NONE, an incoming \c opcode event for \c proxy is merged
+ * into the previous \c opcode event for \c proxy instead of being queued
+ * behind it, but only if that previous event is still the last event on
+ * \c queue and both events carry equal values in every argument whose bit
+ * is set in \c key_args. Otherwise the new event is queued normally and
+ * starts a new run.
+ *
+ * The key arguments keep independent streams apart. For wl_touch.motion,
+ * set the bit of the \c id argument so that the motion of one touch point
+ * never replaces another's; for wl_pointer.axis, wl_pointer.axis_discrete
+ * and wl_pointer.axis_value120, set the bit of the \c axis argument so that
+ * vertical and horizontal scrolling stay separate. Key arguments must be of
+ * type `int` or `uint`; any other bit, or a bit past the last argument,
+ * makes this function fail with errno set to EINVAL.
+ *
+ * WL_EVENT_COALESCE_LATEST keeps the newest event as is.
+ * WL_EVENT_COALESCE_SUM keeps the newest event but adds the `int` and
+ * `fixed` arguments of the replaced events to it, except key arguments,
+ * which are equal anyway. This preserves the accumulated value of axis
+ * events as well as the integer steps of axis_discrete and axis_value120.
+ * `uint` arguments, such as timestamps, are not summed and take the value
+ * of the newest event.
+ *
+ * Any event queued on \c queue in between, whether for \c proxy or for any
+ * other proxy, ends the run. For example, pointer.motion, keyboard.key,
+ * pointer.motion on the same queue stays three events. Events are therefore
+ * never reordered across a non-coalescible event. Events carrying file
+ * descriptors or new objects are never coalesced; setting a policy for such
+ * an event fails with errno set to EINVAL.
+ *
+ * \c proxy must currently be assigned to \c queue, otherwise this function
+ * fails with errno set to EINVAL. The policy belongs to the proxy on that
+ * queue: moving the proxy with wl_proxy_set_queue() clears all of its
+ * policies, and they have to be set again on the new queue. Events that
+ * were already merged stay merged.
+ *
+ * \memberof wl_event_queue
+ */
+WL_EXPORT int
+wl_event_queue_set_coalesce(struct wl_event_queue *queue,
+							struct wl_proxy *proxy, uint32_t opcode,
+							uint32_t key_args,
+							enum wl_event_coalesce_mode mode)
+{
+	return -1;
+}
+
 static int
 message_count_fds(const char *signature)
 {
@@ -542,6 +633,43 @@ wl_proxy_marshal_array_flags(struct wl_proxy *proxy, uint32_t opcode,
 	return NULL;
 }
 
+/** Prepare a request to be sent to the compositor
+ *
+ * \param proxy The proxy object
+ * \param opcode Opcode of the request to be sent
+ * \param interface The interface to use for the new proxy
+ * \param version The protocol object version for the new proxy
+ * \param flags Flags that modify marshalling behaviour
+ * \param args Extra arguments for the given request
+ * \param count Number of elements in \c args
+ * \return A new wl_proxy for the new_id argument or NULL on error
+ *
+ * Behaves like wl_proxy_marshal_array_flags(), but the caller states how
+ * many arguments \c args holds. The count has to match the number of
+ * arguments in the request signature; on mismatch nothing is sent, NULL is
+ * returned and errno is set to EINVAL.
+ *
+ * This entry point is intended for bindings that have already checked the
+ * argument types at compile time, such as C++ wrappers that encode the
+ * signature in a template parameter pack. They can pass a fixed-size array
+ * without going through varargs.
+ *
+ * \note This is intended to be used by language bindings and not in
+ * non-generated code.
+ *
+ * \sa wl_proxy_marshal_array_flags()
+ *
+ * \memberof wl_proxy
+ */
+WL_EXPORT struct wl_proxy *
+wl_proxy_marshal_args_flags(struct wl_proxy *proxy, uint32_t opcode,
+							const struct wl_interface *interface,
+							uint32_t version, uint32_t flags,
+							const union wl_argument *args, size_t count)
+{
+	return NULL;
+}
+
 /** Prepare a request to be sent to the compositor
  *
  * \param proxy The proxy object
@@ -812,6 +940,48 @@ wl_display_roundtrip(struct wl_display *display)
 	return wl_display_roundtrip_queue(display, &display->default_queue);
 }
 
+/** Issue a roundtrip without waiting for it to complete
+ *
+ * \param display The display context object
+ * \param queue The queue on which \c done will be dispatched, or NULL for
+ * the default queue
+ * \param done Function called when the server has answered the roundtrip
+ * \param data User data passed to \c done
+ * \return 0 on success or -1 on failure
+ *
+ * This function sends a wl_display.sync request and returns immediately.
+ * Once the server has processed all requests issued before it, \c done is
+ * called while dispatching \c queue.
+ *
+ * The request is only buffered, not flushed. Several sync points can be
+ * pipelined by calling this function repeatedly, interleaved with other
+ * requests such as registry binds or output queries, and then sending
+ * everything with a single wl_display_flush(). Callbacks issued on the same
+ * \c queue fire in the order their sync points were issued, so startup code
+ * can wait on the last one instead of paying a full round trip for each
+ * step. Callbacks on different queues fire whenever their own queue is
+ * dispatched, with no ordering between queues.
+ *
+ * A pending roundtrip cannot be cancelled. If \c queue is destroyed with
+ * wl_event_queue_destroy() before \c done has been called, the roundtrip
+ * is discarded together with the queue's other pending events: \c done is
+ * never called and \c data is never accessed again, so the caller may free
+ * it once wl_event_queue_destroy() has returned.
+ *
+ * Unlike wl_display_roundtrip_queue(), this function never blocks and may
+ * be called while the thread is prepared for reading events.
+ *
+ * \sa wl_display_roundtrip_queue(), wl_display_flush()
+ * \memberof wl_display
+ */
+WL_EXPORT int
+wl_display_roundtrip_async(struct wl_display *display,
+						   struct wl_event_queue *queue,
+						   wl_roundtrip_func_t done, void *data)
+{
+	return -1;
+}
+
 static int
 create_proxies(struct wl_proxy *sender, struct wl_closure *closure)
 {
@@ -997,6 +1167,54 @@ wl_display_cancel_read(struct wl_display *display)
 	/* NO-OP */
 }
 
+/** Start a library-owned thread that reads events continuously
+ *
+ * \param display The display context object
+ * \return 0 on success or -1 on failure
+ *
+ * Switch \c display to reader thread mode. The library spawns a thread that
+ * waits on the display fd, reads incoming data as soon as it arrives and
+ * queues the events on their event queues. Reading then overlaps with
+ * application work, and event latency no longer depends on when the
+ * application next polls.
+ *
+ * While the reader thread runs, wl_display_prepare_read_queue() and
+ * wl_display_prepare_read() fail with errno set to EBUSY, and
+ * wl_display_dispatch_queue() waits for the reader thread instead of
+ * reading itself. Applications only dispatch, e.g. with
+ * wl_display_dispatch_queue_pending() when wl_event_queue_get_fd() becomes
+ * readable.
+ *
+ * Starting the reader thread when it is already running fails with errno
+ * set to EALREADY.
+ *
+ * \sa wl_display_stop_reader_thread(), wl_event_queue_get_fd()
+ *
+ * \memberof wl_display
+ */
+WL_EXPORT int
+wl_display_start_reader_thread(struct wl_display *display)
+{
+	return -1;
+}
+
+/** Stop the library-owned reader thread
+ *
+ * \param display The display context object
+ *
+ * Stop and join the thread started with wl_display_start_reader_thread() and
+ * return \c display to the cooperative reading protocol. Events that were
+ * already queued stay on their queues. Does nothing if no reader thread is
+ * running. wl_display_disconnect() stops the reader thread implicitly.
+ *
+ * \memberof wl_display
+ */
+WL_EXPORT void
+wl_display_stop_reader_thread(struct wl_display *display)
+{
+	/* NO-OP */
+}
+
 static int
 wl_display_poll(struct wl_display *display, short int events)
 {
@@ -1069,6 +1287,46 @@ wl_display_dispatch_queue_pending(struct wl_display *display,
 	return -1;
 }
 
+/** Dispatch pending events in an event queue within a budget
+ *
+ * \param display The display context object
+ * \param queue The event queue to dispatch
+ * \param max_events Maximum number of events to dispatch, or 0 for no limit
+ * \param deadline_ns CLOCK_MONOTONIC time in nanoseconds after which no
+ * further event is dispatched, or 0 for no deadline
+ * \return The number of events still pending on \c queue, or -1 on failure
+ *
+ * Like wl_display_dispatch_queue_pending(), but stops early once
+ * \c max_events events have been dispatched or \c deadline_ns has passed,
+ * whichever comes first. The deadline is checked between events; a single
+ * listener call is never interrupted. At least one event is dispatched if
+ * the queue is not empty, so repeated calls always make progress.
+ *
+ * A return value of 0 means the queue was drained. A positive value means
+ * events remain, and the caller can interleave other work, e.g. drawing a
+ * frame, before calling this function again. On failure -1 is returned and
+ * errno set appropriately.
+ *
+ * The eventfd returned by wl_event_queue_get_fd() is only reset when this
+ * function drains the queue. While a positive count is returned it stays
+ * readable, so a level-triggered poll wakes the worker again for the
+ * backlog. A worker that registered the fd with EPOLLET gets no new edge
+ * for events that were already pending. It has to keep calling this
+ * function until it returns 0 before it goes back to sleep.
+ *
+ * \sa wl_display_dispatch_queue_pending(), wl_event_queue_get_fd()
+ *
+ * \memberof wl_display
+ */
+WL_EXPORT int
+wl_display_dispatch_queue_pending_budget(struct wl_display *display,
+										 struct wl_event_queue *queue,
+										 uint32_t max_events,
+										 uint64_t deadline_ns)
+{
+	return -1;
+}
+
 /** Process incoming events
  *
  * \param display The display context object
@@ -1129,6 +1387,142 @@ wl_display_dispatch_pending(struct wl_display *display)
 											 &display->default_queue);
 }
 
+/** Create a worker pool that dispatches event queues of a display
+ *
+ * \param display The display context object
+ * \param n_workers Number of worker threads, or 0 for one per online CPU
+ * \return A new dispatch pool or NULL on failure
+ *
+ * Spawn \c n_workers threads that dispatch the event queues registered with
+ * wl_dispatch_pool_add_queue(). The pool starts out empty and never picks up
+ * a queue on its own, so queues that libraries create and dispatch
+ * themselves, e.g. for wl_display_roundtrip_queue(), are left alone.
+ *
+ * Each worker owns a set of registered queues; a worker that runs out of
+ * pending events steals queues with a backlog from the others. A queue is
+ * only ever dispatched by one worker at a time, so events on the same queue
+ * keep their order, while independent queues, e.g. one per window, are
+ * dispatched in parallel. Listeners of registered queues therefore run on
+ * pool threads.
+ *
+ * The workers only dispatch events that are already queued; they never read
+ * from the display fd. Events still have to be read by some other thread,
+ * either by the library reader thread started with
+ * wl_display_start_reader_thread() or by an application loop built on
+ * wl_display_prepare_read() and wl_display_read_events(). A client that
+ * creates a pool and stops reading will not receive any further events.
+ *
+ * \sa wl_dispatch_pool_add_queue(), wl_dispatch_pool_destroy(),
+ * wl_display_start_reader_thread()
+ *
+ * \memberof wl_display
+ */
+WL_EXPORT struct wl_dispatch_pool *
+wl_display_create_dispatch_pool(struct wl_display *display,
+								unsigned int n_workers)
+{
+	return NULL;
+}
+
+/** Hand an event queue over to a dispatch pool
+ *
+ * \param pool The dispatch pool
+ * \param queue The event queue to be dispatched by the pool
+ * \return 0 on success or -1 on failure
+ *
+ * From now on, events on \c queue are dispatched by the workers of
+ * \c pool. Only the owner of \c queue should register it. \c queue must
+ * have been created from the display of \c pool, otherwise this function
+ * fails with errno set to EINVAL. A queue can belong to at most one pool;
+ * registering it twice fails with errno set to EBUSY.
+ *
+ * While \c queue is registered, the application must not dispatch it itself,
+ * whether with wl_display_dispatch_queue(),
+ * wl_display_dispatch_queue_pending(), wl_display_roundtrip_queue() or any
+ * other function that dispatches a queue, and must not destroy it with
+ * wl_event_queue_destroy(). Doing so is undefined. Remove the queue with
+ * wl_dispatch_pool_remove_queue() first.
+ *
+ * \memberof wl_display
+ */
+WL_EXPORT int
+wl_dispatch_pool_add_queue(struct wl_dispatch_pool *pool,
+						   struct wl_event_queue *queue)
+{
+	return -1;
+}
+
+/** Take an event queue back from a dispatch pool
+ *
+ * \param pool The dispatch pool
+ * \param queue The event queue to be removed
+ *
+ * Stop dispatching \c queue from \c pool. If a worker is dispatching
+ * \c queue at the time, this function blocks until that worker has
+ * finished the listener call in progress, so it must not be called from a
+ * listener running on \c queue itself. Once it returns, no worker touches
+ * \c queue anymore, and the caller may dispatch or destroy it. Events still
+ * pending on \c queue are left in place. Does nothing if \c queue is not
+ * registered with \c pool.
+ *
+ * \memberof wl_display
+ */
+WL_EXPORT void
+wl_dispatch_pool_remove_queue(struct wl_dispatch_pool *pool,
+							  struct wl_event_queue *queue)
+{
+	/* NO-OP */
+}
+
+/** Stop and destroy a dispatch pool
+ *
+ * \param pool The dispatch pool to be destroyed
+ *
+ * Remove every queue still registered with \c pool as if by
+ * wl_dispatch_pool_remove_queue(), then join the workers. Events still
+ * pending on the queues are left in place and can be dispatched with
+ * wl_display_dispatch_queue_pending().
+ *
+ * \memberof wl_display
+ */
+WL_EXPORT void
+wl_dispatch_pool_destroy(struct wl_dispatch_pool *pool)
+{
+	/* NO-OP */
+}
+
+/** Retrieve closure allocation statistics for a display
+ *
+ * \param display The display context object
+ * \param stats Filled with the current counters
+ * \param stats_size Size in bytes of the structure \c stats points to,
+ * normally sizeof(struct wl_closure_pool_stats)
+ * \return 0 on success or -1 on failure
+ *
+ * Report how closures for incoming events have been allocated and reused
+ * over the lifetime of \c display, so an application can confirm that the
+ * event path stops allocating once it is warmed up. On failure \c stats is
+ * left untouched.
+ *
+ * New counters are only ever appended to struct wl_closure_pool_stats. Only
+ * the fields that fit entirely within \c stats_size are written, so a caller
+ * built against an older, smaller structure keeps working. If \c stats_size
+ * is larger than the structure known to the library, the extra bytes are
+ * set to zero. A \c stats_size smaller than a single counter fails with
+ * errno set to EINVAL.
+ *
+ * \sa struct wl_closure_pool_stats
+ *
+ * \memberof wl_display
+ */
+WL_EXPORT int
+wl_display_get_closure_pool_stats(struct wl_display *display,
+								  struct wl_closure_pool_stats *stats,
+								  size_t stats_size)
+{
+	return -1;
+}
+
 /** Retrieve the last error that occurred on a display
  *
  * \param display The display context object
@@ -1202,6 +1596,65 @@ wl_display_flush(struct wl_display *display)
 	return -1;
 }
 
+/** Start accumulating requests without flushing
+ *
+ * \param display The display context object
+ * \return 0 on success or -1 on failure
+ *
+ * Open a batch on \c display. Until wl_display_end_batch() is called,
+ * requests marshalled on any proxy of this display are only appended to
+ * the connection buffer, and the marshalling functions never write to the
+ * display fd on their own.
+ *
+ * Instead of being flushed to make room, the connection buffer grows to hold
+ * the whole batch. If it cannot grow, the request is dropped and the display
+ * enters the fatal error state with ENOMEM, as for any other failed marshal.
+ *
+ * Only implicit flushes are held back. An explicit wl_display_flush() inside
+ * a batch sends everything buffered so far, and the batch stays open.
+ * wl_display_roundtrip() and wl_display_roundtrip_queue() flush the same
+ * way, so calling them inside a batch does not hang.
+ *
+ * The batch belongs to \c display, not to the calling thread. While it is
+ * open, requests marshalled by other threads on the same display are held
+ * back as well and go out with the batch.
+ *
+ * This gives clients a deterministic single write per frame: open a batch,
+ * issue the frame's attach, damage, frame and commit requests, then close it.
+ *
+ * Batches do not nest. Opening a batch while one is already open fails with
+ * errno set to EBUSY.
+ *
+ * \sa wl_display_end_batch(), wl_display_flush()
+ * \memberof wl_display
+ */
+WL_EXPORT int
+wl_display_begin_batch(struct wl_display *display)
+{
+	return -1;
+}
+
+/** Close a batch and send the accumulated requests
+ *
+ * \param display The display context object
+ * \return The number of bytes sent on success or -1 on failure
+ *
+ * Close the batch opened with wl_display_begin_batch() and send everything
+ * buffered with a single wl_display_flush(). The return value and errno
+ * follow wl_display_flush(); in particular, -1 with errno set to EAGAIN means
+ * the batch was closed but not all data could be written yet.
+ *
+ * Closing a batch when none is open fails with errno set to EINVAL.
+ *
+ * \sa wl_display_begin_batch(), wl_display_flush()
+ * \memberof wl_display
+ */
+WL_EXPORT int
+wl_display_end_batch(struct wl_display *display)
+{
+	return -1;
+}
+
 /** Set the user data associated with a proxy
  *
  * \param proxy The proxy object
@@ -1223,6 +1676,10 @@ wl_proxy_set_user_data(struct wl_proxy *proxy, void *user_data)
  * \param proxy The proxy object
  * \return The user data associated with proxy
  *
+ * This function does not take the display lock. Concurrent calls from
+ * several threads are safe, but it must not race with
+ * wl_proxy_set_user_data() on the same proxy, which is a plain store.
+ *
  * \memberof wl_proxy
  */
 WL_EXPORT void *
@@ -1245,6 +1702,8 @@ wl_proxy_get_user_data(struct wl_proxy *proxy)
  *
  * wl_display's version will always return 0.
  *
+ * Like wl_proxy_get_user_data(), this function is lock-free.
+ *
  * \memberof wl_proxy
  */
 WL_EXPORT uint32_t
@@ -1258,6 +1717,8 @@ wl_proxy_get_version(struct wl_proxy *proxy)
  * \param proxy The proxy object
  * \return The id the object associated with the proxy
  *
+ * Like wl_proxy_get_user_data(), this function is lock-free.
+ *
  * \memberof wl_proxy
  */
 WL_EXPORT uint32_t
@@ -1319,6 +1780,9 @@ wl_proxy_set_tag(struct wl_proxy *proxy,
  *
  * See wl_proxy_set_tag for details.
  *
+ * Like wl_proxy_get_user_data(), this function is lock-free and must not
+ * race with wl_proxy_set_tag() on the same proxy.
+ *
  * \param proxy The proxy object
  *
  * \memberof wl_proxy
@@ -1456,6 +1920,67 @@ wl_proxy_wrapper_destroy(void *proxy_wrapper)
 	/* NO-OP */
 }
 
+/** Initialize a proxy wrapper in caller-provided storage
+ *
+ * \param storage Storage that will hold the wrapper
+ * \param proxy The proxy object to be wrapped
+ * \param queue The event queue for objects created through the wrapper, or
+ * NULL for the display's default queue
+ * \return A proxy wrapper for the given proxy or NULL on failure
+ *
+ * This function behaves like wl_proxy_create_wrapper() followed by
+ * wl_proxy_set_queue() on the wrapper, except that the wrapper lives in
+ * \c storage instead of being allocated. Because the target queue is passed
+ * in rather than copied from \c proxy, it takes neither the display lock nor
+ * any memory from the heap, which makes it cheap to wrap a proxy right before
+ * every cross-queue constructor request:
+ *
+ * \code
+ *
+ *   struct wl_proxy_wrapper_storage storage;
+ *   struct wl_display *wrapped_display;
+ *   struct wl_callback *callback;
+ *
+ *   wrapped_display = wl_proxy_init_wrapper(&storage, display, queue);
+ *   callback = wl_display_sync(wrapped_display);
+ *   wl_proxy_wrapper_fini(wrapped_display);
+ *
+ * \endcode
+ *
+ * Since no lock is taken, the caller must make sure that the queue of
+ * \c proxy is not changed with wl_proxy_set_queue() while this function
+ * runs.
+ *
+ * The same lifetime rules as for wl_proxy_create_wrapper() apply: the
+ * wrapper must be released with wl_proxy_wrapper_fini() before \c storage
+ * goes out of scope and before the wrapped proxy is destroyed. Passing such
+ * a wrapper to wl_proxy_wrapper_destroy() is invalid.
+ *
+ * \sa wl_proxy_create_wrapper(), wl_proxy_wrapper_fini()
+ *
+ * \memberof wl_proxy
+ */
+WL_EXPORT void *
+wl_proxy_init_wrapper(struct wl_proxy_wrapper_storage *storage, void *proxy,
+					  struct wl_event_queue *queue)
+{
+	return NULL;
+}
+
+/** Release a proxy wrapper initialized in caller-provided storage
+ * \param proxy_wrapper The proxy wrapper to be released
+ *
+ * The storage passed to wl_proxy_init_wrapper() is not freed and may be
+ * reused afterwards.
+ *
+ * \memberof wl_proxy
+ */
+WL_EXPORT void
+wl_proxy_wrapper_fini(void *proxy_wrapper)
+{
+	/* NO-OP */
+}
+
 WL_EXPORT void
 wl_log_set_handler_client(wl_log_func_t handler)
 {
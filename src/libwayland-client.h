@@ -57,6 +57,30 @@ struct wl_callback_listener
 				 uint32_t callback_data);
 };
 
+/**
+ * Worker pool dispatching registered event queues of a display
+ *
+ * Opaque handle created with wl_display_create_dispatch_pool() and released
+ * with wl_dispatch_pool_destroy().
+ */
+struct wl_dispatch_pool;
+
+/**
+ * Caller-provided storage for a proxy wrapper
+ *
+ * A `wl_proxy_wrapper_storage` is large enough, and suitably aligned, to hold
+ * a proxy wrapper initialized with wl_proxy_init_wrapper(). It is usually
+ * declared on the stack for the duration of a single request. Its contents
+ * are opaque.
+ *
+ * \sa wl_proxy_init_wrapper
+ */
+struct wl_proxy_wrapper_storage
+{
+	/** Opaque wrapper state */
+	void *opaque[16];
+};
+
 /**
  * Dispatcher function type alias
  *
@@ -85,6 +109,25 @@ typedef int (*wl_dispatcher_func_t)(const void *user_data, void *target,
 									uint32_t opcode, const struct wl_message *msg,
 									union wl_argument *args);
 
+struct wl_display;
+
+/**
+ * Asynchronous roundtrip completion callback type alias
+ *
+ * A `wl_roundtrip_func_t` is invoked by wl_display_roundtrip_async() once the
+ * server has processed every request issued before the corresponding sync
+ * point. It is called from the dispatch of the queue the roundtrip was
+ * started on, like any other listener.
+ *
+ * \param data User data passed to wl_display_roundtrip_async()
+ * \param display The display the roundtrip was issued on
+ * \param serial The serial carried by the wl_callback.done event
+ *
+ * \sa wl_display_roundtrip_async
+ */
+typedef void (*wl_roundtrip_func_t)(void *data, struct wl_display *display,
+									uint32_t serial);
+
 /**
  * Log function type alias
  *
@@ -111,6 +154,54 @@ typedef int (*wl_dispatcher_func_t)(const void *user_data, void *target,
  */
 typedef void (*wl_log_func_t)(const char *fmt, va_list args) WL_PRINTF(1, 0);
 
+/**
+ * Closure allocation statistics
+ *
+ * Counters describing how closures for incoming events were obtained over the
+ * lifetime of a wl_display. A closure that is not freed after dispatch but
+ * kept for a later event counts as recycled. In steady state `heap_allocs`
+ * should stop growing.
+ *
+ * Counters are only ever added at the end of the structure; callers pass
+ * its size to wl_display_get_closure_pool_stats() so that older binaries
+ * keep working when it grows.
+ *
+ * \sa wl_display_get_closure_pool_stats
+ */
+struct wl_closure_pool_stats
+{
+	/** Closures allocated from the heap */
+	uint64_t heap_allocs;
+	/** Closures obtained by reusing a previously recycled one */
+	uint64_t reused;
+	/** Closures kept for reuse after dispatch instead of being freed */
+	uint64_t recycled;
+	/** Closures currently kept for reuse */
+	uint64_t cached;
+};
+
+/**
+ * Event coalescing policy for an event queue
+ *
+ * Selects how an incoming event is merged with an earlier event of the same
+ * proxy and opcode while both wait on a wl_event_queue. Merging only happens
+ * when that earlier event is the last event on the queue and both agree on
+ * every key argument, e.g. the touch id or the axis; any other event, from
+ * any proxy, ends the run, so events are never reordered.
+ *
+ * \sa wl_event_queue_set_coalesce
+ */
+enum wl_event_coalesce_mode
+{
+	/** Queue every event (default) */
+	WL_EVENT_COALESCE_NONE,
+	/** Keep only the most recent event, e.g. for motion */
+	WL_EVENT_COALESCE_LATEST,
+	/** Keep the latest event with its non-key `int` and `fixed` arguments
+	 *  summed, e.g. for axis, axis_discrete and axis_value120 */
+	WL_EVENT_COALESCE_SUM
+};
+
 /**
  * @ingroup iface_wl_buffer
  * @struct wl_buffer_interface